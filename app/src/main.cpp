@@ -1,16 +1,69 @@
+#include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <table/table.hpp>
+#include <table/utils.hpp>
+#ifdef WITH_SHARDING
+#include <sharded/sharded_table.hpp>
+#endif
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
+    dialect::Options options;
+    std::vector<std::string_view> arguments;
+    for (int index = 1; index < argc; ++index) {
+        std::string_view argument = argv[index];
+        if (argument == "--semicolon") {
+            options.delimiter = ';';
+        } else if (argument == "--quoted") {
+            options.quoting = true;
+        } else if (argument == "--crlf") {
+            options.crlf = true;
+        } else if (argument.substr(0, 2) == "--") {
+            std::cerr << "Invalid arguments" << std::endl;
+            return 1;
+        } else {
+            arguments.emplace_back(argument);
+        }
+    }
+#ifdef WITH_SHARDING
+    if (arguments.size() != 1u && arguments.size() != 2u) {
+#else
+    if (arguments.size() != 1u) {
+#endif
         std::cerr << "Invalid arguments" << std::endl;
         return 1;
     }
-    std::string_view filename = argv[1];
+    std::string_view filename = arguments.front();
     try {
-        auto table = Table::fromFile(filename);
+#ifdef WITH_SHARDING
+        std::int64_t shardsCount = 0;
+        if (arguments.size() == 2u) {
+            std::string shardsArgument(arguments.back());
+            try {
+                if (utils::isInteger(shardsArgument)) {
+                    shardsCount = utils::parseInteger(shardsArgument);
+                }
+            } catch (std::runtime_error &) {
+            }
+            if (shardsCount <= 0) {
+                throw std::runtime_error("Number of shards must be a positive integer: " + shardsArgument);
+            }
+        }
+#endif
+#ifdef WITH_SHARDING
+        if (shardsCount > 0) {
+            std::ifstream file(filename.data());
+            if (!file.is_open()) {
+                throw std::runtime_error("Cannot open file");
+            }
+            ShardedTable(static_cast<size_t>(shardsCount), options).calculate(file, std::cout);
+            return 0;
+        }
+#endif
+        auto table = Table::fromFile(filename, options);
         table.calculate();
         table.print(std::cout);
     } catch (std::runtime_error &error) {
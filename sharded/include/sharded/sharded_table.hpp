@@ -0,0 +1,37 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+
+#include <table/dialect.hpp>
+#include <table/table.hpp>
+
+#include "transport.hpp"
+
+// Splits a table by row id ranges and calculates every shard in its own worker process.
+// The coordinator reads the input twice: the row ids first to choose the ranges, then the
+// rows, which are sent to their workers over the transport. Workers push calculated values
+// through the coordinator to the shards that use them, the coordinator detects cycles that
+// span shards, and the result is streamed back in the original rows order. The coordinator
+// keeps only the row ids and every worker only its shard. Workers are started by forking,
+// so they run on the same host as the coordinator.
+class ShardedTable {
+  public:
+    explicit ShardedTable(size_t shardsCount, const dialect::Options &options = {},
+                          ChannelFactory channelFactory = SocketTransport::unixChannel);
+
+    // Input is read twice, so it must be seekable
+    void calculate(std::istream &input, std::ostream &output) const;
+
+    // Receives a shard over the transport and calculates it, calculate() runs this in a forked process
+    static void runWorker(Transport &transport);
+
+  private:
+    using RowId = Table::RowId;
+
+    class Worker;
+
+    size_t shardsCount;
+    dialect::Options options;
+    ChannelFactory channelFactory;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+// Bidirectional channel that delivers whole frames between the coordinator and a forked worker
+class Transport {
+  public:
+    virtual ~Transport() = default;
+
+    virtual void send(const std::string &frame) = 0;
+    virtual std::string receive() = 0;
+    // Descriptor which becomes readable when a frame arrives
+    virtual int descriptor() const = 0;
+};
+
+using Channel = std::pair<std::unique_ptr<Transport>, std::unique_ptr<Transport>>;
+using ChannelFactory = std::function<Channel()>;
+
+class SocketTransport : public Transport {
+  public:
+    explicit SocketTransport(int fd);
+    SocketTransport(const SocketTransport &) = delete;
+    SocketTransport(SocketTransport &&) = delete;
+    ~SocketTransport() override;
+
+    SocketTransport &operator=(const SocketTransport &) = delete;
+    SocketTransport &operator=(SocketTransport &&) = delete;
+
+    void send(const std::string &frame) override;
+    std::string receive() override;
+    int descriptor() const override;
+
+    static Channel unixChannel();
+    static Channel tcpChannel();
+
+  private:
+    void writeAll(const char *buffer, size_t size);
+    void readAll(char *buffer, size_t size);
+
+    int fd;
+};
@@ -0,0 +1,710 @@
+#include "sharded_table.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+enum class MessageType : std::uint8_t {
+    Setup,     // coordinator assigns a shard and the format of its rows to a worker
+    Rows,      // lines of consecutive rows, the input of a shard or its printed result
+    Finished,  // all rows have been sent
+    Subscribe, // worker asks another shard for the values of its cells once they are calculated
+    Values,    // values of cells pushed to a subscribed worker
+    Idle,      // worker has handled the given number of subscriptions and pushes
+    Abort,     // worker failed to calculate its shard
+    Shutdown,  // coordinator asks worker to send the result
+    Header     // printed header of the result
+};
+
+struct Message {
+    Message() = default;
+    Message(MessageType type, std::uint64_t origin) : type(type), origin(origin) {
+    }
+
+    MessageType type = MessageType::Setup;
+    // Worker which subscribed to the values, for other messages the one which sent it
+    std::uint64_t origin = 0;
+    std::uint64_t rowId = 0;
+    std::uint64_t count = 0;
+    std::int64_t value = 0;
+    std::string text;
+};
+
+template <typename T>
+void appendValue(std::string &frame, T value) {
+    frame.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+T extractValue(const std::string &frame, size_t &offset) {
+    if (offset + sizeof(T) > frame.size()) {
+        throw std::runtime_error("Malformed frame received from transport");
+    }
+    T value;
+    std::memcpy(&value, frame.data() + offset, sizeof(value));
+    offset += sizeof(value);
+    return value;
+}
+
+void appendString(std::string &frame, std::string_view str) {
+    appendValue(frame, static_cast<std::uint32_t>(str.size()));
+    frame += str;
+}
+
+std::string extractString(const std::string &frame, size_t &offset) {
+    auto length = extractValue<std::uint32_t>(frame, offset);
+    if (offset + length > frame.size()) {
+        throw std::runtime_error("Malformed frame received from transport");
+    }
+    std::string str = frame.substr(offset, length);
+    offset += length;
+    return str;
+}
+
+void appendAddress(std::string &frame, const Table::Address &address) {
+    appendValue(frame, address.second);
+    appendString(frame, address.first);
+}
+
+Table::Address extractAddress(const std::string &frame, size_t &offset) {
+    auto rowId = extractValue<Table::RowId>(frame, offset);
+    return Table::Address(extractString(frame, offset), rowId);
+}
+
+// Frames never leave the host, so fields are stored in the native byte order
+std::string encodeMessage(const Message &message) {
+    std::string frame;
+    frame.reserve(sizeof(std::uint8_t) + 4u * sizeof(std::uint64_t) + message.text.size());
+    appendValue(frame, static_cast<std::uint8_t>(message.type));
+    appendValue(frame, message.origin);
+    appendValue(frame, message.rowId);
+    appendValue(frame, message.count);
+    appendValue(frame, message.value);
+    frame += message.text;
+    return frame;
+}
+
+void sendMessage(Transport &transport, const Message &message) {
+    transport.send(encodeMessage(message));
+}
+
+Message receiveMessage(Transport &transport) {
+    std::string frame = transport.receive();
+    size_t offset = 0;
+    Message message;
+    message.type = static_cast<MessageType>(extractValue<std::uint8_t>(frame, offset));
+    message.origin = extractValue<std::uint64_t>(frame, offset);
+    message.rowId = extractValue<std::uint64_t>(frame, offset);
+    message.count = extractValue<std::uint64_t>(frame, offset);
+    message.value = extractValue<std::int64_t>(frame, offset);
+    message.text = frame.substr(offset);
+    return message;
+}
+
+// Sends frames to a worker from a separate thread, so the coordinator keeps reading
+// other workers while this one is busy and does not drain its socket. Frames for a worker
+// which has gone are dropped, the coordinator learns why it has gone from its messages.
+class Outbox {
+  public:
+    explicit Outbox(Transport &transport) : transport(transport), thread([this] { run(); }) {
+    }
+    Outbox(const Outbox &) = delete;
+    Outbox(Outbox &&) = delete;
+    ~Outbox() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        condition.notify_one();
+        thread.join();
+    }
+
+    Outbox &operator=(const Outbox &) = delete;
+    Outbox &operator=(Outbox &&) = delete;
+
+    void post(const Message &message) {
+        std::string frame = encodeMessage(message);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (failed) {
+                return;
+            }
+            frames.emplace_back(std::move(frame));
+        }
+        condition.notify_one();
+    }
+
+  private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            condition.wait(lock, [this] { return stopped || !frames.empty(); });
+            if (frames.empty()) {
+                return;
+            }
+            std::string frame = std::move(frames.front());
+            frames.pop_front();
+            lock.unlock();
+            try {
+                transport.send(frame);
+            } catch (std::runtime_error &) {
+                lock.lock();
+                failed = true;
+                frames.clear();
+                return;
+            }
+            lock.lock();
+        }
+    }
+
+    Transport &transport;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::string> frames;
+    bool stopped = false;
+    bool failed = false;
+    std::thread thread;
+};
+
+// Every frame of rows is about this size, so neither side buffers a whole shard at once
+constexpr size_t ROWS_FRAME_SIZE = 64u * 1024u;
+
+// Boundaries hold the first row id of every shard, shards cover ascending non-overlapping ranges
+size_t shardByRowId(const std::vector<Table::RowId> &boundaries, Table::RowId rowId) {
+    auto iter = std::upper_bound(boundaries.begin(), boundaries.end(), rowId);
+    if (iter == boundaries.begin()) {
+        return 0u;
+    }
+    return static_cast<size_t>(std::prev(iter) - boundaries.begin());
+}
+
+// Rows with malformed ids still go to some shard, which reports them while parsing
+Table::RowId parseRowId(std::string_view field) {
+    try {
+        std::int64_t rowId = std::stoll(std::string(field));
+        return rowId < 0 ? 0u : static_cast<Table::RowId>(rowId);
+    } catch (std::logic_error &) {
+        return 0u;
+    }
+}
+
+std::vector<std::string> receiveLines(Transport &transport) {
+    std::vector<std::string> lines;
+    for (Message rows = receiveMessage(transport); rows.type != MessageType::Finished;
+         rows = receiveMessage(transport)) {
+        if (rows.type != MessageType::Rows) {
+            throw std::runtime_error("Unexpected message received by worker");
+        }
+        size_t offset = 0;
+        while (offset < rows.text.size()) {
+            lines.emplace_back(extractString(rows.text, offset));
+        }
+    }
+    return lines;
+}
+
+void stopWorkers(const std::vector<pid_t> &workers, bool force) {
+    for (pid_t pid : workers) {
+        if (force) {
+            ::kill(pid, SIGKILL);
+        }
+    }
+    for (pid_t pid : workers) {
+        while (::waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {
+        }
+    }
+}
+} // namespace
+
+// Calculates a shard as values arrive: every cell whose operands are known is calculated locally
+// and pushed to the shards which subscribed to it, so each value crosses the transport once per
+// subscriber. Cells left when no worker can make progress wait on a cycle.
+class ShardedTable::Worker {
+  public:
+    Worker(Table table, Transport &transport, size_t index, std::vector<RowId> boundaries);
+
+    void run(size_t rowsCount);
+
+  private:
+    // Index of an operand paired with the index of a pending cell which uses it
+    using Dependency = std::pair<size_t, size_t>;
+    // Worker to notify and the index the value has in its remoteAddresses
+    using Subscriber = std::pair<std::uint64_t, std::uint64_t>;
+
+    void trackDependencies();
+    void resolve(const std::vector<Dependency> &dependencies, size_t operand);
+    void calculateLocally();
+    void subscribe();
+    void addSubscribers(const Message &subscription);
+    void applyValues(const Message &values);
+    void publish();
+    void reportIdle();
+    std::int64_t lookupValue(const Table::Address &address) const;
+    void sendRows();
+
+    Table table;
+    Transport &transport;
+    std::uint64_t index;
+    std::vector<RowId> boundaries;
+    // Sorted cells which were not calculated initially and the number of their operands still unknown
+    std::vector<Table::Address> pendingCells;
+    std::vector<size_t> unresolved;
+    std::vector<size_t> ready;
+    size_t pendingCount = 0;
+    // Sorted by operand, local operands are indices in pendingCells and remote ones in remoteAddresses
+    std::vector<Dependency> localDependencies;
+    std::vector<Dependency> remoteDependencies;
+    // Distinct addresses of other shards used by pending cells, sorted
+    std::vector<Table::Address> remoteAddresses;
+    std::vector<std::int64_t> remoteValues;
+    std::vector<bool> remoteKnown;
+    // Workers to notify once a pending cell is calculated
+    std::vector<std::vector<Subscriber>> subscribers;
+    // Values waiting to be pushed to every shard
+    std::vector<std::string> published;
+    // Subscriptions and pushes handled, the coordinator compares it with the number it has forwarded
+    std::uint64_t handled = 0;
+};
+
+ShardedTable::Worker::Worker(Table table, Transport &transport, size_t index, std::vector<RowId> boundaries)
+    : table(std::move(table)), transport(transport), index(index), boundaries(std::move(boundaries)) {
+}
+
+void ShardedTable::Worker::run(size_t rowsCount) {
+    table.setRemoteLookup([this](const Table::Address &address, size_t) { return lookupValue(address); },
+                          rowsCount);
+    trackDependencies();
+    calculateLocally();
+    subscribe();
+    reportIdle();
+    while (true) {
+        Message message = receiveMessage(transport);
+        switch (message.type) {
+        case MessageType::Subscribe:
+            addSubscribers(message);
+            break;
+        case MessageType::Values:
+            applyValues(message);
+            calculateLocally();
+            break;
+        case MessageType::Shutdown:
+            sendRows();
+            return;
+        default:
+            throw std::runtime_error("Unexpected message received by worker");
+        }
+        ++handled;
+        publish();
+        reportIdle();
+    }
+}
+
+void ShardedTable::Worker::trackDependencies() {
+    pendingCells = table.pendingCells();
+    std::sort(pendingCells.begin(), pendingCells.end());
+    pendingCount = pendingCells.size();
+    unresolved.assign(pendingCount, 0u);
+    std::vector<std::pair<Table::Address, size_t>> remoteOperands;
+    for (size_t dependent = 0; dependent < pendingCells.size(); ++dependent) {
+        for (auto &operand : table.references(pendingCells[dependent])) {
+            if (!table.containsRow(operand.second)) {
+                remoteOperands.emplace_back(std::move(operand), dependent);
+                ++unresolved[dependent];
+                continue;
+            }
+            // Calculated operands and invalid columns are left for valueAt, which reports the latter
+            auto iter = std::lower_bound(pendingCells.begin(), pendingCells.end(), operand);
+            if (iter != pendingCells.end() && *iter == operand) {
+                localDependencies.emplace_back(static_cast<size_t>(iter - pendingCells.begin()), dependent);
+                ++unresolved[dependent];
+            }
+        }
+        if (unresolved[dependent] == 0u) {
+            ready.emplace_back(dependent);
+        }
+    }
+    std::sort(localDependencies.begin(), localDependencies.end());
+
+    std::sort(remoteOperands.begin(), remoteOperands.end());
+    remoteDependencies.reserve(remoteOperands.size());
+    for (auto &[address, dependent] : remoteOperands) {
+        if (remoteAddresses.empty() || remoteAddresses.back() != address) {
+            remoteAddresses.emplace_back(std::move(address));
+        }
+        remoteDependencies.emplace_back(remoteAddresses.size() - 1u, dependent);
+    }
+    remoteValues.assign(remoteAddresses.size(), 0);
+    remoteKnown.assign(remoteAddresses.size(), false);
+    subscribers.resize(pendingCells.size());
+    published.resize(boundaries.size());
+}
+
+void ShardedTable::Worker::resolve(const std::vector<Dependency> &dependencies, size_t operand) {
+    auto iter = std::lower_bound(dependencies.begin(), dependencies.end(), Dependency(operand, 0u));
+    for (; iter != dependencies.end() && iter->first == operand; ++iter) {
+        if (--unresolved[iter->second] == 0u) {
+            ready.emplace_back(iter->second);
+        }
+    }
+}
+
+void ShardedTable::Worker::calculateLocally() {
+    while (!ready.empty()) {
+        size_t cell = ready.back();
+        ready.pop_back();
+        // All operands are known, so this neither recurses nor waits for other shards
+        std::int64_t value = table.valueAt(pendingCells[cell], 1u);
+        --pendingCount;
+        resolve(localDependencies, cell);
+        for (const auto &[shard, address] : subscribers[cell]) {
+            appendValue(published[shard], address);
+            appendValue(published[shard], value);
+        }
+        std::vector<Subscriber>().swap(subscribers[cell]);
+    }
+}
+
+void ShardedTable::Worker::subscribe() {
+    std::vector<Message> subscriptions(boundaries.size(), Message(MessageType::Subscribe, index));
+    for (size_t address = 0; address < remoteAddresses.size(); ++address) {
+        auto &subscription = subscriptions[shardByRowId(boundaries, remoteAddresses[address].second)];
+        // The coordinator routes the subscription by any row of the shard
+        subscription.rowId = remoteAddresses[address].second;
+        appendValue(subscription.text, static_cast<std::uint64_t>(address));
+        appendAddress(subscription.text, remoteAddresses[address]);
+    }
+    for (const auto &subscription : subscriptions) {
+        if (!subscription.text.empty()) {
+            sendMessage(transport, subscription);
+        }
+    }
+}
+
+void ShardedTable::Worker::addSubscribers(const Message &subscription) {
+    auto &values = published.at(subscription.origin);
+    size_t offset = 0;
+    while (offset < subscription.text.size()) {
+        auto address = extractValue<std::uint64_t>(subscription.text, offset);
+        Table::Address cell = extractAddress(subscription.text, offset);
+        auto iter = std::lower_bound(pendingCells.begin(), pendingCells.end(), cell);
+        if (iter == pendingCells.end() || *iter != cell) {
+            // Throws for cells which do not exist, the same way as a single table does
+            appendValue(values, address);
+            appendValue(values, table.valueAt(cell, 1u));
+            continue;
+        }
+        size_t pending = static_cast<size_t>(iter - pendingCells.begin());
+        if (auto value = table.calculatedValue(cell)) {
+            appendValue(values, address);
+            appendValue(values, *value);
+        } else {
+            subscribers[pending].emplace_back(subscription.origin, address);
+        }
+    }
+}
+
+void ShardedTable::Worker::applyValues(const Message &values) {
+    size_t offset = 0;
+    while (offset < values.text.size()) {
+        auto address = static_cast<size_t>(extractValue<std::uint64_t>(values.text, offset));
+        auto value = extractValue<std::int64_t>(values.text, offset);
+        if (address >= remoteAddresses.size()) {
+            throw std::runtime_error("Malformed frame received from transport");
+        }
+        if (!remoteKnown[address]) {
+            remoteValues[address] = value;
+            remoteKnown[address] = true;
+            resolve(remoteDependencies, address);
+        }
+    }
+}
+
+void ShardedTable::Worker::publish() {
+    for (size_t shard = 0; shard < published.size(); ++shard) {
+        if (published[shard].empty()) {
+            continue;
+        }
+        Message values(MessageType::Values, shard);
+        values.text.swap(published[shard]);
+        sendMessage(transport, values);
+    }
+}
+
+void ShardedTable::Worker::reportIdle() {
+    Message idle(MessageType::Idle, index);
+    idle.count = handled;
+    idle.value = static_cast<std::int64_t>(pendingCount);
+    sendMessage(transport, idle);
+}
+
+std::int64_t ShardedTable::Worker::lookupValue(const Table::Address &address) const {
+    // Cells are calculated only once all their operands are known
+    auto iter = std::lower_bound(remoteAddresses.begin(), remoteAddresses.end(), address);
+    size_t position = static_cast<size_t>(iter - remoteAddresses.begin());
+    if (iter == remoteAddresses.end() || *iter != address || !remoteKnown[position]) {
+        throw std::runtime_error("Value of another shard is not known yet");
+    }
+    return remoteValues[position];
+}
+
+void ShardedTable::Worker::sendRows() {
+    std::ostringstream stream;
+    if (index == 0u) {
+        Message header(MessageType::Header, index);
+        table.printHeader(stream);
+        header.text = stream.str();
+        sendMessage(transport, header);
+    }
+    Message rows(MessageType::Rows, index);
+    for (RowId rowId : table.rowIds()) {
+        stream.str(std::string());
+        table.printRow(stream, rowId);
+        appendString(rows.text, stream.str());
+        if (rows.text.size() >= ROWS_FRAME_SIZE) {
+            sendMessage(transport, rows);
+            rows.text.clear();
+        }
+    }
+    if (!rows.text.empty()) {
+        sendMessage(transport, rows);
+    }
+    sendMessage(transport, Message(MessageType::Finished, index));
+}
+
+ShardedTable::ShardedTable(size_t shardsCount, const dialect::Options &options, ChannelFactory channelFactory)
+    : shardsCount(shardsCount), options(options), channelFactory(std::move(channelFactory)) {
+    if (shardsCount == 0u) {
+        throw std::runtime_error("Table must be split into at least one shard");
+    }
+}
+
+void ShardedTable::runWorker(Transport &transport) {
+    Message setup = receiveMessage(transport);
+    if (setup.type != MessageType::Setup) {
+        throw std::runtime_error("Unexpected message received by worker");
+    }
+    try {
+        size_t offset = 0;
+        dialect::Options shardOptions;
+        shardOptions.delimiter = extractValue<char>(setup.text, offset);
+        shardOptions.quoting = extractValue<std::uint8_t>(setup.text, offset) != 0u;
+        shardOptions.crlf = extractValue<std::uint8_t>(setup.text, offset) != 0u;
+        std::vector<RowId> boundaries;
+        while (offset < setup.text.size()) {
+            boundaries.emplace_back(extractValue<RowId>(setup.text, offset));
+        }
+        Worker worker(Table::fromLines(receiveLines(transport), shardOptions), transport, setup.origin,
+                      std::move(boundaries));
+        worker.run(setup.rowId);
+    } catch (std::runtime_error &error) {
+        Message abort(MessageType::Abort, setup.origin);
+        abort.text = error.what();
+        sendMessage(transport, abort);
+    }
+}
+
+void ShardedTable::calculate(std::istream &input, std::ostream &output) const {
+    std::vector<RowId> rowsIds;
+    std::string line;
+    if (std::getline(input, line)) {
+        dialect::dispatch(options, [&input, &line, &rowsIds](auto policy) {
+            while (std::getline(input, line)) {
+                rowsIds.emplace_back(parseRowId(dialect::firstField<decltype(policy)>(line)));
+            }
+        });
+    }
+    if (rowsIds.empty()) {
+        throw std::runtime_error("Table must have at least two rows including heading");
+    }
+
+    std::vector<RowId> boundaries;
+    size_t count = 0;
+    {
+        // Duplicate ids are reported by the shard that gets them, every shard needs a row of its own
+        std::vector<RowId> sortedIds = rowsIds;
+        std::sort(sortedIds.begin(), sortedIds.end());
+        sortedIds.erase(std::unique(sortedIds.begin(), sortedIds.end()), sortedIds.end());
+        count = std::min(shardsCount, sortedIds.size());
+        boundaries.reserve(count);
+        for (size_t index = 0; index < count; ++index) {
+            boundaries.emplace_back(sortedIds[index * sortedIds.size() / count]);
+        }
+    }
+
+    std::vector<Channel> channels;
+    channels.reserve(count);
+    for (size_t index = 0; index < count; ++index) {
+        channels.emplace_back(channelFactory());
+    }
+
+    std::vector<pid_t> workers;
+    workers.reserve(count);
+    for (size_t index = 0; index < count; ++index) {
+        pid_t pid = ::fork();
+        if (pid < 0) {
+            stopWorkers(workers, true);
+            throw std::runtime_error(std::string("Cannot start worker process: ") + std::strerror(errno));
+        }
+        if (pid == 0) {
+            int status = 0;
+            try {
+                for (size_t other = 0; other < channels.size(); ++other) {
+                    channels[other].first.reset();
+                    if (other != index) {
+                        channels[other].second.reset();
+                    }
+                }
+                runWorker(*channels[index].second);
+            } catch (...) {
+                status = 1;
+            }
+            // Skip destructors and atexit handlers inherited from the coordinator
+            ::_exit(status);
+        }
+        workers.emplace_back(pid);
+        channels[index].second.reset();
+    }
+
+    std::vector<std::unique_ptr<Transport>> transports;
+    transports.reserve(channels.size());
+    for (auto &channel : channels) {
+        transports.emplace_back(std::move(channel.first));
+    }
+    // Destroyed before the transports they write to
+    std::vector<std::unique_ptr<Outbox>> outboxes;
+    outboxes.reserve(transports.size());
+
+    try {
+        std::vector<pollfd> descriptors;
+        descriptors.reserve(transports.size());
+        for (const auto &transport : transports) {
+            outboxes.emplace_back(std::make_unique<Outbox>(*transport));
+            descriptors.push_back(pollfd{transport->descriptor(), POLLIN, 0});
+        }
+
+        for (size_t index = 0; index < count; ++index) {
+            Message setup(MessageType::Setup, index);
+            setup.rowId = rowsIds.size();
+            appendValue(setup.text, options.delimiter);
+            appendValue(setup.text, static_cast<std::uint8_t>(options.quoting));
+            appendValue(setup.text, static_cast<std::uint8_t>(options.crlf));
+            for (RowId boundary : boundaries) {
+                appendValue(setup.text, boundary);
+            }
+            outboxes[index]->post(setup);
+        }
+        // Every shard gets the header followed by its rows, as they are in the input
+        input.clear();
+        input.seekg(0);
+        std::getline(input, line);
+        std::vector<Message> rows(count, Message(MessageType::Rows, 0u));
+        for (auto &frame : rows) {
+            appendString(frame.text, line);
+        }
+        size_t rowIndex = 0;
+        for (; rowIndex < rowsIds.size() && std::getline(input, line); ++rowIndex) {
+            size_t shard = shardByRowId(boundaries, rowsIds[rowIndex]);
+            appendString(rows[shard].text, line);
+            if (rows[shard].text.size() >= ROWS_FRAME_SIZE) {
+                outboxes[shard]->post(rows[shard]);
+                rows[shard].text.clear();
+            }
+        }
+        if (rowIndex != rowsIds.size()) {
+            throw std::runtime_error("Cannot read the table again");
+        }
+        for (size_t index = 0; index < count; ++index) {
+            if (!rows[index].text.empty()) {
+                outboxes[index]->post(rows[index]);
+            }
+            outboxes[index]->post(Message(MessageType::Finished, 0u));
+        }
+
+        // Every subscription and push passes through here, so a worker is idle once it reports having
+        // handled all of them. When all workers are idle, nothing is in flight and nothing can change.
+        std::vector<std::uint64_t> forwarded(count);
+        std::vector<bool> idle(count);
+        std::vector<std::int64_t> pending(count);
+        while (std::find(idle.begin(), idle.end(), false) != idle.end()) {
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Cannot wait for workers: ") + std::strerror(errno));
+            }
+            for (size_t index = 0; index < descriptors.size(); ++index) {
+                if (descriptors[index].revents == 0) {
+                    continue;
+                }
+                Message message = receiveMessage(*transports[index]);
+                size_t target = 0;
+                switch (message.type) {
+                case MessageType::Subscribe:
+                case MessageType::Values:
+                    target = message.type == MessageType::Subscribe ? shardByRowId(boundaries, message.rowId)
+                                                                    : static_cast<size_t>(message.origin);
+                    ++forwarded.at(target);
+                    idle[target] = false;
+                    outboxes[target]->post(message);
+                    break;
+                case MessageType::Idle:
+                    idle[index] = message.count == forwarded[index];
+                    pending[index] = message.value;
+                    break;
+                case MessageType::Abort:
+                    throw std::runtime_error(message.text);
+                default:
+                    throw std::runtime_error("Unexpected message received by coordinator");
+                }
+            }
+        }
+        // Missing cells are reported by their shards, so the cells left wait on each other
+        if (std::any_of(pending.begin(), pending.end(), [](std::int64_t cells) { return cells != 0; })) {
+            throw std::runtime_error("Detected address cycle during calculations");
+        }
+
+        for (const auto &outbox : outboxes) {
+            outbox->post(Message(MessageType::Shutdown, 0u));
+        }
+        Message header = receiveMessage(*transports.front());
+        if (header.type != MessageType::Header) {
+            throw std::runtime_error("Unexpected message received by coordinator");
+        }
+        output << header.text << '\n';
+        // Workers send their rows in the input order, so every row is the next one of its shard
+        std::vector<Message> frames(count);
+        std::vector<size_t> offsets(count);
+        for (RowId rowId : rowsIds) {
+            size_t shard = shardByRowId(boundaries, rowId);
+            while (offsets[shard] == frames[shard].text.size()) {
+                frames[shard] = receiveMessage(*transports[shard]);
+                offsets[shard] = 0;
+                if (frames[shard].type != MessageType::Rows) {
+                    throw std::runtime_error("Unexpected message received by coordinator");
+                }
+            }
+            output << extractString(frames[shard].text, offsets[shard]) << '\n';
+        }
+        for (size_t index = 0; index < count; ++index) {
+            if (offsets[index] != frames[index].text.size() ||
+                receiveMessage(*transports[index]).type != MessageType::Finished) {
+                throw std::runtime_error("Unexpected message received by coordinator");
+            }
+        }
+    } catch (...) {
+        stopWorkers(workers, true);
+        throw;
+    }
+    stopWorkers(workers, false);
+}
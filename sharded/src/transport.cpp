@@ -0,0 +1,119 @@
+#include "transport.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+std::runtime_error systemError(const std::string &what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+} // namespace
+
+SocketTransport::SocketTransport(int fd) : fd(fd) {
+}
+
+SocketTransport::~SocketTransport() {
+    ::close(fd);
+}
+
+void SocketTransport::send(const std::string &frame) {
+    // Length prefix and payload go out in one write so small frames are not split into two packets
+    auto size = static_cast<std::uint32_t>(frame.size());
+    std::string buffer(reinterpret_cast<const char *>(&size), sizeof(size));
+    buffer += frame;
+    writeAll(buffer.data(), buffer.size());
+}
+
+std::string SocketTransport::receive() {
+    std::uint32_t size = 0;
+    readAll(reinterpret_cast<char *>(&size), sizeof(size));
+    std::string frame(size, '\0');
+    readAll(frame.data(), frame.size());
+    return frame;
+}
+
+int SocketTransport::descriptor() const {
+    return fd;
+}
+
+void SocketTransport::writeAll(const char *buffer, size_t size) {
+    while (size > 0u) {
+        ssize_t written = ::send(fd, buffer, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("Cannot send frame");
+        }
+        buffer += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void SocketTransport::readAll(char *buffer, size_t size) {
+    while (size > 0u) {
+        ssize_t received = ::recv(fd, buffer, size, 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("Cannot receive frame");
+        }
+        if (received == 0) {
+            throw std::runtime_error("Transport connection closed");
+        }
+        buffer += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+Channel SocketTransport::unixChannel() {
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        throw systemError("Cannot create unix socket pair");
+    }
+    return Channel(std::make_unique<SocketTransport>(fds[0]), std::make_unique<SocketTransport>(fds[1]));
+}
+
+Channel SocketTransport::tcpChannel() {
+    int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw systemError("Cannot create tcp socket");
+    }
+    // Owns the listener until both ends of the connection are established
+    SocketTransport listenerGuard(listener);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    if (::bind(listener, reinterpret_cast<sockaddr *>(&address), length) != 0 || ::listen(listener, 1) != 0 ||
+        ::getsockname(listener, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+        throw systemError("Cannot listen on localhost");
+    }
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (client < 0) {
+        throw systemError("Cannot create tcp socket");
+    }
+    auto clientEnd = std::make_unique<SocketTransport>(client);
+    if (::connect(client, reinterpret_cast<sockaddr *>(&address), length) != 0) {
+        throw systemError("Cannot connect to localhost");
+    }
+    int server = ::accept(listener, nullptr, nullptr);
+    if (server < 0) {
+        throw systemError("Cannot accept connection on localhost");
+    }
+    auto serverEnd = std::make_unique<SocketTransport>(server);
+    // Frames are request/reply pairs, so waiting to coalesce them only adds latency
+    int noDelay = 1;
+    ::setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    ::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    return Channel(std::move(serverEnd), std::move(clientEnd));
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dialect {
+using CharClass = std::array<bool, 256>;
+
+constexpr std::string_view CELL_CHARACTERS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890=+-*/";
+constexpr char QUOTE = '"';
+
+constexpr CharClass makeCharClass(std::string_view characters, char delimiter, bool quoting) {
+    CharClass result{};
+    for (char ch : characters) {
+        result[static_cast<unsigned char>(ch)] = true;
+    }
+    result[static_cast<unsigned char>(delimiter)] = true;
+    if (quoting) {
+        result[static_cast<unsigned char>(QUOTE)] = true;
+    }
+    return result;
+}
+
+// Format of the input lines, every combination is compiled into its own parsing loop
+template <char Delimiter, bool Quoting, bool CrLf>
+struct Policy {
+    static constexpr char delimiter = Delimiter;
+    static constexpr bool quoting = Quoting;
+    static constexpr bool crlf = CrLf;
+    static constexpr CharClass allowed = makeCharClass(CELL_CHARACTERS, Delimiter, Quoting);
+};
+
+using Default = Policy<',', false, false>;
+
+// Runtime description of the format used to pick one of the compiled policies
+struct Options {
+    char delimiter = ',';
+    bool quoting = false;
+    bool crlf = false;
+};
+
+template <typename Policy>
+std::string_view trimLineEnding(std::string_view line) {
+    if constexpr (Policy::crlf) {
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1u);
+        }
+    }
+    return line;
+}
+
+template <typename Policy>
+bool isValidLine(std::string_view line) {
+    // No early exit, so the loop stays free of branches
+    bool valid = true;
+    for (char ch : line) {
+        valid &= Policy::allowed[static_cast<unsigned char>(ch)];
+    }
+    return valid;
+}
+
+template <typename Policy>
+std::vector<std::string> splitLine(std::string_view line) {
+    std::vector<std::string> tokens;
+    if constexpr (!Policy::quoting) {
+        size_t tokenBegin = 0;
+        size_t tokenEnd = line.find(Policy::delimiter);
+        while (tokenEnd != std::string_view::npos) {
+            tokens.emplace_back(line.substr(tokenBegin, tokenEnd - tokenBegin));
+            tokenBegin = tokenEnd + 1u;
+            tokenEnd = line.find(Policy::delimiter, tokenBegin);
+        }
+        tokens.emplace_back(line.substr(tokenBegin));
+    } else {
+        // Quotes may only wrap a whole field, and the unquoted field must still be a valid cell,
+        // so neither the delimiter nor a quote can reach the table and break the printed output
+        constexpr char separators[] = {Policy::delimiter, QUOTE, '\0'};
+        size_t index = 0;
+        while (true) {
+            std::string_view token;
+            if (index < line.size() && line[index] == QUOTE) {
+                size_t closingQuote = line.find(QUOTE, index + 1u);
+                if (closingQuote == std::string_view::npos) {
+                    throw std::runtime_error("Unterminated quoted field");
+                }
+                token = line.substr(index + 1u, closingQuote - index - 1u);
+                index = closingQuote + 1u;
+                if (index < line.size() && line[index] != Policy::delimiter) {
+                    throw std::runtime_error("Invalid characters");
+                }
+            } else {
+                size_t tokenEnd = std::min(line.find(Policy::delimiter, index), line.size());
+                token = line.substr(index, tokenEnd - index);
+                index = tokenEnd;
+            }
+            if (token.find_first_of(separators) != std::string_view::npos) {
+                throw std::runtime_error("Invalid characters");
+            }
+            tokens.emplace_back(token);
+            if (index == line.size()) {
+                break;
+            }
+            ++index;
+        }
+    }
+    return tokens;
+}
+
+// First field of a line without splitting the rest, malformed lines are left for splitLine to report
+template <typename Policy>
+std::string_view firstField(std::string_view line) {
+    line = trimLineEnding<Policy>(line);
+    if constexpr (Policy::quoting) {
+        if (!line.empty() && line.front() == QUOTE) {
+            return line.substr(1u, line.find(QUOTE, 1u) - 1u);
+        }
+    }
+    return line.substr(0, line.find(Policy::delimiter));
+}
+
+template <char Delimiter, bool Quoting, typename Function>
+auto dispatchLineEnding(const Options &options, Function &&function) {
+    if (options.crlf) {
+        return function(Policy<Delimiter, Quoting, true>{});
+    }
+    return function(Policy<Delimiter, Quoting, false>{});
+}
+
+template <char Delimiter, typename Function>
+auto dispatchQuoting(const Options &options, Function &&function) {
+    if (options.quoting) {
+        return dispatchLineEnding<Delimiter, true>(options, std::forward<Function>(function));
+    }
+    return dispatchLineEnding<Delimiter, false>(options, std::forward<Function>(function));
+}
+
+// Calls function with the policy matching options
+template <typename Function>
+auto dispatch(const Options &options, Function &&function) {
+    switch (options.delimiter) {
+    case ',':
+        return dispatchQuoting<','>(options, std::forward<Function>(function));
+    case ';':
+        return dispatchQuoting<';'>(options, std::forward<Function>(function));
+    default:
+        throw std::runtime_error(std::string("Unsupported delimiter ") + options.delimiter);
+    }
+}
+} // namespace dialect
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <string_view>
@@ -9,8 +12,16 @@
 #include <variant>
 #include <vector>
 
+#include "dialect.hpp"
+
 class Table {
   public:
+    using RowId = std::uint64_t;
+    using ColumnId = std::string;
+    using Address = std::pair<ColumnId, RowId>;
+    // Resolves addresses of rows which are stored elsewhere, used when this table is a shard of a larger one
+    using RemoteLookup = std::function<std::int64_t(const Address &address, size_t depth)>;
+
     Table(const Table &) = default;
     Table(Table &&) = default;
     ~Table() = default;
@@ -18,16 +29,27 @@ class Table {
     Table &operator=(const Table &) = default;
     Table &operator=(Table &&) = default;
 
-    static Table fromLines(const std::vector<std::string> &lines);
-    static Table fromFile(const std::string_view &filename);
+    static Table fromLines(const std::vector<std::string> &lines, const dialect::Options &options = {});
+    static Table fromFile(const std::string_view &filename, const dialect::Options &options = {});
 
     void calculate();
     void print(std::ostream &stream) const;
 
+    // Makes this table a shard of a table with rowsCount rows, the rest of which is read through lookup
+    void setRemoteLookup(RemoteLookup lookup, size_t rowsCount);
+    bool containsRow(RowId rowId) const;
+    const std::vector<RowId> &rowIds() const;
+    // Cells which still hold formulas and the addresses used by the formula of such a cell
+    std::vector<Address> pendingCells() const;
+    std::vector<Address> references(const Address &cell) const;
+    // Value of a cell of this table if it is calculated already
+    std::optional<std::int64_t> calculatedValue(const Address &cell) const;
+    // Calculates a cell of this table if needed, depth is the length of the chain that led to it
+    std::int64_t valueAt(const Address &cell, size_t depth);
+    void printHeader(std::ostream &stream) const;
+    void printRow(std::ostream &stream, RowId rowId) const;
+
   private:
-    using RowId = std::uint64_t;
-    using ColumnId = std::string;
-    using Address = std::pair<ColumnId, RowId>;
 
     struct Formula {
         char operation;
@@ -51,16 +73,19 @@ class Table {
 
     Table() = default;
 
+    template <typename Policy>
+    static Table parseLines(const std::vector<std::string> &lines);
+
     void setColumnNames(const std::vector<std::string> &names);
     void insertRow(const std::vector<std::string> &rowValues);
     std::int64_t valueByAddress(const std::variant<std::int64_t, Address> &cellAddress, size_t depth);
     void calculateCell(Cell &cell, size_t depth);
-
-    static bool isValidString(const std::string &str);
+    const Cell *findCell(const Address &address) const;
 
     std::unordered_map<ColumnId, size_t> columns;
     std::unordered_map<RowId, Row> data;
     size_t cellsCount;
     std::vector<std::string_view> columnsNames;
     std::vector<RowId> rowsIds;
+    RemoteLookup remoteLookup;
 };
@@ -5,31 +5,35 @@
 #include <fstream>
 #include <stdexcept>
 
+#include "dialect.hpp"
 #include "utils.hpp"
 
-bool Table::isValidString(const std::string &str) {
-    constexpr const char *const ALLOWED = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890=+-*/,";
-    return str.find_first_not_of(ALLOWED) == std::string::npos;
+Table Table::fromLines(const std::vector<std::string> &lines, const dialect::Options &options) {
+    return dialect::dispatch(options, [&lines](auto policy) { return parseLines<decltype(policy)>(lines); });
 }
 
-Table Table::fromLines(const std::vector<std::string> &lines) {
+template <typename Policy>
+Table Table::parseLines(const std::vector<std::string> &lines) {
     if (lines.size() < 2u) {
         throw std::runtime_error("Table must have at least two rows including heading");
     }
+    std::vector<std::string_view> trimmedLines;
+    trimmedLines.reserve(lines.size());
     for (const auto &line : lines) {
-        if (!isValidString(line)) {
+        auto trimmedLine = dialect::trimLineEnding<Policy>(line);
+        if (!dialect::isValidLine<Policy>(trimmedLine)) {
             throw std::runtime_error("Invalid characters");
         }
+        trimmedLines.emplace_back(trimmedLine);
     }
     Table table;
-    std::vector<std::string> rawColumnNames = utils::splitString(lines.front(), ',');
+    std::vector<std::string> rawColumnNames = dialect::splitLine<Policy>(trimmedLines.front());
     table.setColumnNames(rawColumnNames);
     size_t countColumns = table.columns.size();
     table.columnsNames.reserve(countColumns);
     table.rowsIds.reserve(lines.size() - 1u);
-    for (auto iter = std::next(lines.begin()); iter != lines.end(); ++iter) {
-        const auto &rowLine = *iter;
-        auto rowValues = utils::splitString(rowLine, ',');
+    for (auto iter = std::next(trimmedLines.begin()); iter != trimmedLines.end(); ++iter) {
+        auto rowValues = dialect::splitLine<Policy>(*iter);
         if (rowValues.size() - 1u != countColumns) {
             throw std::runtime_error("The number of cells in a row must match the number of columns");
         }
@@ -88,7 +92,7 @@ void Table::insertRow(const std::vector<std::string> &rowValues) {
     rowsIds.emplace_back(rowId);
 }
 
-Table Table::fromFile(const std::string_view &filename) {
+Table Table::fromFile(const std::string_view &filename, const dialect::Options &options) {
     std::ifstream file(filename.data());
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file");
@@ -98,26 +102,34 @@ Table Table::fromFile(const std::string_view &filename) {
     while (std::getline(file, line)) {
         lines.emplace_back(std::move(line));
     }
-    return fromLines(lines);
+    return fromLines(lines, options);
 }
 
 void Table::print(std::ostream &stream) const {
+    printHeader(stream);
+    stream << '\n';
+    for (RowId rowId : rowsIds) {
+        printRow(stream, rowId);
+        stream << '\n';
+    }
+}
+
+void Table::printHeader(std::ostream &stream) const {
     for (const auto &name : columnsNames) {
         stream << ',' << name;
     }
-    stream << '\n';
-    for (RowId rowId : rowsIds) {
-        stream << rowId;
-        const auto &row = data.at(rowId);
-        for (const auto &cell : row) {
-            stream << ',';
-            if (cell.calculated()) {
-                stream << std::get<std::int64_t>(cell.value);
-            } else {
-                stream << cell.raw;
-            }
+}
+
+void Table::printRow(std::ostream &stream, RowId rowId) const {
+    stream << rowId;
+    const auto &row = data.at(rowId);
+    for (const auto &cell : row) {
+        stream << ',';
+        if (cell.calculated()) {
+            stream << std::get<std::int64_t>(cell.value);
+        } else {
+            stream << cell.raw;
         }
-        stream << '\n';
     }
 }
 
@@ -181,6 +193,9 @@ std::int64_t Table::valueByAddress(const std::variant<std::int64_t, Address> &ce
         size_t columnIndex = iterColumn->second;
         auto iterRow = data.find(address.second);
         if (iterRow == data.end()) {
+            if (remoteLookup) {
+                return remoteLookup(address, depth);
+            }
             throw std::runtime_error("Invalid row id in address " + address.first + std::to_string(address.second));
         }
         auto &cell = iterRow->second[columnIndex];
@@ -223,3 +238,69 @@ void Table::calculateCell(Table::Cell &cell, size_t depth) {
     }
     cell.value = result;
 }
+
+void Table::setRemoteLookup(RemoteLookup lookup, size_t rowsCount) {
+    remoteLookup = std::move(lookup);
+    // Cycles are detected against the size of the whole table
+    cellsCount = rowsCount * columns.size();
+}
+
+bool Table::containsRow(RowId rowId) const {
+    return data.count(rowId) != 0u;
+}
+
+const std::vector<Table::RowId> &Table::rowIds() const {
+    return rowsIds;
+}
+
+std::vector<Table::Address> Table::pendingCells() const {
+    std::vector<Address> cells;
+    for (RowId rowId : rowsIds) {
+        const auto &row = data.at(rowId);
+        for (size_t index = 0; index < row.size(); ++index) {
+            if (!row[index].calculated()) {
+                cells.emplace_back(std::string(columnsNames[index]), rowId);
+            }
+        }
+    }
+    return cells;
+}
+
+std::vector<Table::Address> Table::references(const Address &cell) const {
+    std::vector<Address> addresses;
+    const Cell *found = findCell(cell);
+    if (found == nullptr || found->calculated()) {
+        return addresses;
+    }
+    const auto &formula = std::get<Formula>(found->value);
+    for (const auto *operand : {&formula.left, &formula.right}) {
+        if (std::holds_alternative<Address>(*operand)) {
+            addresses.emplace_back(std::get<Address>(*operand));
+        }
+    }
+    return addresses;
+}
+
+std::optional<std::int64_t> Table::calculatedValue(const Address &cell) const {
+    const Cell *found = findCell(cell);
+    if (found == nullptr || !found->calculated()) {
+        return std::nullopt;
+    }
+    return std::get<std::int64_t>(found->value);
+}
+
+std::int64_t Table::valueAt(const Address &cell, size_t depth) {
+    if (data.count(cell.second) == 0u) {
+        throw std::runtime_error("Invalid row id in address " + cell.first + std::to_string(cell.second));
+    }
+    return valueByAddress(cell, depth);
+}
+
+const Table::Cell *Table::findCell(const Address &address) const {
+    auto iterColumn = columns.find(address.first);
+    auto iterRow = data.find(address.second);
+    if (iterColumn == columns.end() || iterRow == data.end()) {
+        return nullptr;
+    }
+    return &iterRow->second[iterColumn->second];
+}
@@ -3,26 +3,6 @@
 #include <algorithm>
 #include <stdexcept>
 
-std::vector<std::string> utils::splitString(const std::string &str, char delimiter) {
-    if (str.empty()) {
-        return {""};
-    }
-    std::vector<std::string> tokens;
-    auto tokenBegin = str.begin();
-    auto tokenEnd = tokenBegin;
-    while (tokenBegin != str.end()) {
-        while (tokenEnd != str.end() && *tokenEnd != delimiter)
-            ++tokenEnd;
-        tokens.emplace_back(tokenBegin, tokenEnd);
-        if (tokenEnd != str.end())
-            ++tokenEnd;
-        tokenBegin = tokenEnd;
-    }
-    if (str.back() == delimiter)
-        tokens.emplace_back();
-    return tokens;
-}
-
 std::int64_t utils::parseInteger(const std::string &str) {
     std::int64_t value = 0;
     try {
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+
+#include "sharded/sharded_table.hpp"
+
+namespace {
+std::string calculate(const std::vector<std::string> &lines, size_t shardsCount,
+                      ChannelFactory channelFactory = SocketTransport::unixChannel,
+                      const dialect::Options &options = {}) {
+    std::stringstream input;
+    for (const auto &line : lines) {
+        input << line << '\n';
+    }
+    std::stringstream result;
+    ShardedTable(shardsCount, options, channelFactory).calculate(input, result);
+    return result.str();
+}
+
+// Column A of every row adds one to the previous row of a chain which alternates between two shards
+std::vector<std::string> alternatingChain(size_t length, const std::string &first) {
+    std::vector<std::string> lines = {",A"};
+    for (size_t row = 0; row < length; ++row) {
+        size_t link = row < length / 2u ? 2u * row : 2u * (row - length / 2u) + 1u;
+        size_t previous = link % 2u == 0u ? (link - 1u) / 2u + length / 2u : link / 2u;
+        lines.emplace_back(std::to_string(row) + "," + (link == 0u ? first : "=A" + std::to_string(previous) + "+1"));
+    }
+    return lines;
+}
+} // namespace
+
+TEST(ShardedTable, can_calculate_with_one_shard) {
+    auto result = calculate(
+        {
+            ",A,B,Cell",
+            "1,1,0,1",
+            "2,2,=A1+Cell30,0",
+            "30,0,=B1+A1,5",
+        },
+        1u);
+    std::string answer = ",A,B,Cell\n"
+                         "1,1,0,1\n"
+                         "2,2,6,0\n"
+                         "30,0,1,5\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_with_references_between_shards) {
+    auto result = calculate(
+        {
+            ",A,B,Cell",
+            "0,1,1,=A1+B0",
+            "1,=B1+Cell1,=Cell1+A0,=A0+B0",
+        },
+        2u);
+    std::string answer = ",A,B,Cell\n"
+                         "0,1,1,6\n"
+                         "1,5,3,2\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_chain_through_all_shards) {
+    auto result = calculate(
+        {
+            ",A,B",
+            "0,1,=A5+B4",
+            "1,=A4+1,=B0*2",
+            "2,=A0+1,=B5-1",
+            "3,=A1+1,=B1+A3",
+            "4,=A2+1,=A4*A4",
+            "5,=A3+1,=B4+B3",
+        },
+        3u);
+    std::string answer = ",A,B\n"
+                         "0,1,15\n"
+                         "1,4,30\n"
+                         "2,2,43\n"
+                         "3,5,35\n"
+                         "4,3,9\n"
+                         "5,6,44\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_with_unordered_rows) {
+    auto result = calculate(
+        {
+            ",A,B,Cell",
+            "0,1,1,=A0+B0",
+            "2,=B1+Cell1,=A2-Cell1,=A2*B2",
+            "1,=Cell0+B0,=Cell0+A1,=A1+B1",
+        },
+        3u);
+    std::string answer = ",A,B,Cell\n"
+                         "0,1,1,2\n"
+                         "2,13,5,65\n"
+                         "1,3,5,8\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_with_more_shards_than_rows) {
+    auto result = calculate(
+        {
+            ",A,B",
+            "5,=B7+1,2",
+            "7,3,=B5*2",
+        },
+        8u);
+    std::string answer = ",A,B\n"
+                         "5,5,2\n"
+                         "7,3,4\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_with_long_column_names) {
+    auto result = calculate(
+        {
+            ",LongColumnNameNumberOne,LongColumnNameNumberTwo",
+            "1,1,=LongColumnNameNumberOne3+LongColumnNameNumberTwo2",
+            "2,=LongColumnNameNumberOne1+1,=LongColumnNameNumberTwo4*2",
+            "3,=LongColumnNameNumberTwo4+1,=LongColumnNameNumberOne2+LongColumnNameNumberOne4",
+            "4,=LongColumnNameNumberOne1*3,5",
+        },
+        2u);
+    std::string answer = ",LongColumnNameNumberOne,LongColumnNameNumberTwo\n"
+                         "1,1,16\n"
+                         "2,2,10\n"
+                         "3,6,5\n"
+                         "4,3,5\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_long_chain_between_shards) {
+    std::stringstream result(calculate(alternatingChain(2000u, "1"), 2u));
+    std::string line;
+    std::getline(result, line);
+    std::getline(result, line);
+    ASSERT_EQ(line, "0,1");
+    std::getline(result, line);
+    ASSERT_EQ(line, "1,3");
+    std::getline(result, line);
+    ASSERT_EQ(line, "2,5");
+}
+
+TEST(ShardedTable, can_calculate_over_tcp) {
+    auto result = calculate(
+        {
+            ",A,B,Cell",
+            "0,1,1,=A0+B0",
+            "1,=Cell0+B0,=Cell0+A1,=A1+B1",
+            "2,=B1+Cell1,=A2-Cell1,=A2*B2",
+        },
+        3u, SocketTransport::tcpChannel);
+    std::string answer = ",A,B,Cell\n"
+                         "0,1,1,2\n"
+                         "1,3,5,8\n"
+                         "2,13,5,65\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_calculate_semicolon_quoted_table) {
+    dialect::Options options;
+    options.delimiter = ';';
+    options.quoting = true;
+    auto result = calculate(
+        {
+            ";A;\"B\"",
+            "\"1\";1;=A2+1",
+            "2;=A1+1;\"3\"",
+        },
+        2u, SocketTransport::unixChannel, options);
+    std::string answer = ",A,B\n"
+                         "1,1,3\n"
+                         "2,2,3\n";
+    ASSERT_EQ(result, answer);
+}
+
+TEST(ShardedTable, can_throw_exception_zero_shards) {
+    ASSERT_THROW(ShardedTable(0u), std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_only_header) {
+    ASSERT_THROW(calculate({",A,B"}, 2u), std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_duplicate_row_ids) {
+    ASSERT_THROW(calculate({",A", "0,1", "0,2"}, 2u), std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_invalid_row_id) {
+    ASSERT_THROW(calculate({",A", "1,1", "x,2"}, 2u), std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_cycle_between_shards) {
+    ASSERT_THROW(calculate(
+                     {
+                         ",A,B",
+                         "0,=A1+1,1",
+                         "1,=A0+1,1",
+                     },
+                     2u),
+                 std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_invalid_row_name_in_address) {
+    ASSERT_THROW(calculate(
+                     {
+                         ",A,B",
+                         "0,=A5+1,1",
+                         "10,1,1",
+                     },
+                     2u),
+                 std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_division_by_zero_in_other_shard) {
+    ASSERT_THROW(calculate(
+                     {
+                         ",A,B",
+                         "0,=B1+1,1",
+                         "1,1,=A1/0",
+                     },
+                     2u),
+                 std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_long_cycle_between_shards) {
+    ASSERT_THROW(calculate(alternatingChain(2000u, "=A1999+1"), 2u), std::runtime_error);
+}
+
+TEST(ShardedTable, can_throw_exception_invalid_column_name_in_other_shard) {
+    ASSERT_THROW(calculate(
+                     {
+                         ",A,B",
+                         "0,=C1+1,1",
+                         "1,1,1",
+                     },
+                     2u),
+                 std::runtime_error);
+}
@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "sharded/transport.hpp"
+
+TEST(Transport, can_send_frames_over_unix_socket) {
+    auto channel = SocketTransport::unixChannel();
+    channel.first->send("=A1+Cell30");
+    channel.first->send("");
+    ASSERT_EQ(channel.second->receive(), "=A1+Cell30");
+    ASSERT_EQ(channel.second->receive(), "");
+}
+
+TEST(Transport, can_send_frames_over_tcp) {
+    auto channel = SocketTransport::tcpChannel();
+    channel.second->send("1,1,0,1");
+    ASSERT_EQ(channel.first->receive(), "1,1,0,1");
+}
+
+TEST(Transport, can_send_large_frame) {
+    auto channel = SocketTransport::unixChannel();
+    // Fits into the socket buffer, so sending does not wait for the reader
+    std::string frame(1u << 16u, 'A');
+    channel.first->send(frame);
+    ASSERT_EQ(channel.second->receive(), frame);
+}
+
+TEST(Transport, can_throw_exception_connection_closed) {
+    auto channel = SocketTransport::unixChannel();
+    channel.first.reset();
+    ASSERT_THROW(channel.second->receive(), std::runtime_error);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <tuple>
+
+#include "table/dialect.hpp"
+
+using Semicolon = dialect::Policy<';', false, false>;
+using Quoted = dialect::Policy<',', true, false>;
+using CrLf = dialect::Policy<',', false, true>;
+
+TEST(Dialect, can_split_empty_line) {
+    std::vector<std::string> answer = {""};
+    ASSERT_EQ(dialect::splitLine<dialect::Default>(""), answer);
+}
+
+TEST(Dialect, can_split_empty_parts) {
+    std::vector<std::string> answer = {"2", "", "=A1+Cell30", "", ""};
+    ASSERT_EQ(dialect::splitLine<dialect::Default>("2,,=A1+Cell30,,"), answer);
+}
+
+TEST(Dialect, can_split_line_semicolon) {
+    std::vector<std::string> answer = {"2", "=A1+Cell30", "0"};
+    ASSERT_EQ(dialect::splitLine<Semicolon>("2;=A1+Cell30;0"), answer);
+}
+
+TEST(Dialect, can_split_quoted_line) {
+    std::vector<std::string> answer = {"2", "=A1+Cell30", "", "", "Cell"};
+    ASSERT_EQ(dialect::splitLine<Quoted>("\"2\",=A1+Cell30,\"\",,\"Cell\""), answer);
+}
+
+TEST(Dialect, can_throw_exception_delimiter_in_quoted_field) {
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,\"A,B\""), std::runtime_error);
+}
+
+TEST(Dialect, can_throw_exception_escaped_quote_in_quoted_field) {
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,\"\"\"\""), std::runtime_error);
+}
+
+TEST(Dialect, can_throw_exception_quote_inside_field) {
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,1,2\"3\""), std::runtime_error);
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,=\"A,B1\"+1"), std::runtime_error);
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,\"2\"3"), std::runtime_error);
+}
+
+TEST(Dialect, can_throw_exception_unterminated_quoted_field) {
+    ASSERT_THROW(dialect::splitLine<Quoted>("1,\"2"), std::runtime_error);
+}
+
+TEST(Dialect, can_trim_line_ending) {
+    ASSERT_EQ(dialect::trimLineEnding<CrLf>("1,2\r"), "1,2");
+    ASSERT_EQ(dialect::trimLineEnding<dialect::Default>("1,2\r"), "1,2\r");
+}
+
+TEST(Dialect, can_extract_first_field) {
+    ASSERT_EQ(dialect::firstField<dialect::Default>("12,=A1+1,3"), "12");
+    ASSERT_EQ(dialect::firstField<dialect::Default>("12"), "12");
+    ASSERT_EQ(dialect::firstField<Semicolon>("12;3"), "12");
+    ASSERT_EQ(dialect::firstField<Quoted>("\"12\",3"), "12");
+    ASSERT_EQ(dialect::firstField<CrLf>("12\r"), "12");
+}
+
+TEST(Dialect, can_check_allowed_characters) {
+    ASSERT_TRUE(dialect::isValidLine<dialect::Default>(",A,B,Cell"));
+    ASSERT_FALSE(dialect::isValidLine<dialect::Default>(";A;B;Cell"));
+    ASSERT_TRUE(dialect::isValidLine<Semicolon>(";A;B;Cell"));
+    ASSERT_FALSE(dialect::isValidLine<Semicolon>(",A,B,Cell"));
+    ASSERT_FALSE(dialect::isValidLine<dialect::Default>("1,\"2\""));
+    ASSERT_TRUE(dialect::isValidLine<Quoted>("1,\"2\""));
+}
+
+TEST(Dialect, can_throw_exception_unsupported_delimiter) {
+    dialect::Options options;
+    options.delimiter = '|';
+    ASSERT_THROW(dialect::dispatch(options, [](auto policy) { return policy.delimiter; }), std::runtime_error);
+}
+
+TEST(Dialect, can_dispatch_options) {
+    dialect::Options options;
+    options.delimiter = ';';
+    options.crlf = true;
+    auto policy = dialect::dispatch(options, [](auto policy) {
+        return std::make_tuple(policy.delimiter, policy.quoting, policy.crlf);
+    });
+    ASSERT_EQ(policy, std::make_tuple(';', false, true));
+}
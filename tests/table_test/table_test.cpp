@@ -209,3 +209,105 @@ TEST(Table, can_throw_exception_negative_row_id) {
                  }),
                  std::runtime_error);
 }
+
+TEST(Table, can_calculate_with_semicolon_delimiter) {
+    dialect::Options options;
+    options.delimiter = ';';
+    auto table = Table::fromLines(
+        {
+            ";A;B;Cell",
+            "1;1;0;1",
+            "2;2;=A1+Cell30;0",
+            "30;0;=B1+A1;5",
+        },
+        options);
+    table.calculate();
+    std::stringstream result;
+    table.print(result);
+    std::string answer = ",A,B,Cell\n"
+                         "1,1,0,1\n"
+                         "2,2,6,0\n"
+                         "30,0,1,5\n";
+    ASSERT_EQ(result.str(), answer);
+}
+
+TEST(Table, can_calculate_with_quoted_fields_and_crlf) {
+    dialect::Options options;
+    options.quoting = true;
+    options.crlf = true;
+    auto table = Table::fromLines(
+        {
+            ",\"A\",B,Cell\r",
+            "\"1\",1,0,1\r",
+            "2,2,\"=A1+Cell30\",0\r",
+            "30,0,=B1+A1,\"5\"\r",
+        },
+        options);
+    table.calculate();
+    std::stringstream result;
+    table.print(result);
+    std::string answer = ",A,B,Cell\n"
+                         "1,1,0,1\n"
+                         "2,2,6,0\n"
+                         "30,0,1,5\n";
+    ASSERT_EQ(result.str(), answer);
+}
+
+TEST(Table, can_throw_exception_crlf_without_option) {
+    ASSERT_THROW(Table::fromLines({
+                     ",A,B\r",
+                     "1,1,0\r",
+                 }),
+                 std::runtime_error);
+}
+
+TEST(Table, can_throw_exception_comma_in_semicolon_table) {
+    dialect::Options options;
+    options.delimiter = ';';
+    ASSERT_THROW(Table::fromLines(
+                     {
+                         ";A;B",
+                         "1;1,0",
+                     },
+                     options),
+                 std::runtime_error);
+}
+
+TEST(Table, can_throw_exception_delimiter_in_quoted_column_name) {
+    dialect::Options options;
+    options.quoting = true;
+    ASSERT_THROW(Table::fromLines(
+                     {
+                         ",\"A,B\",C",
+                         "1,1,2",
+                     },
+                     options),
+                 std::runtime_error);
+}
+
+TEST(Table, can_list_pending_cells_and_references) {
+    auto table = Table::fromLines({
+        ",A,B",
+        "1,1,=A1+A7",
+        "2,=B1*2,3",
+    });
+    std::vector<Table::Address> pending = {{"B", 1u}, {"A", 2u}};
+    ASSERT_EQ(table.pendingCells(), pending);
+    std::vector<Table::Address> references = {{"A", 1u}, {"A", 7u}};
+    ASSERT_EQ(table.references({"B", 1u}), references);
+    ASSERT_TRUE(table.references({"A", 1u}).empty());
+}
+
+TEST(Table, can_calculate_cell_with_remote_lookup) {
+    auto table = Table::fromLines({
+        ",A,B",
+        "1,1,=A1+A7",
+        "2,=B1*2,3",
+    });
+    table.setRemoteLookup([](const Table::Address &, size_t) { return 10; }, 3u);
+    ASSERT_FALSE(table.calculatedValue({"A", 2u}).has_value());
+    ASSERT_EQ(table.valueAt({"A", 2u}, 1u), 22);
+    ASSERT_EQ(table.calculatedValue({"B", 1u}), 11);
+    ASSERT_FALSE(table.calculatedValue({"A", 7u}).has_value());
+    ASSERT_THROW(table.valueAt({"A", 7u}, 1u), std::runtime_error);
+}